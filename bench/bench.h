@@ -0,0 +1,139 @@
+// Minimal benchmark harness shared by the bench_* programs.
+//
+// Each benchmark times every call of an operation individually and reports item throughput,
+// latency percentiles and heap allocations per call. Allocations are counted on every thread
+// that has not opted out, by replacing the global operator new/delete, so this header must be
+// included by exactly one translation unit.
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+std::atomic<size_t> allocationCount(0);
+std::atomic<size_t> allocationBytes(0);
+
+// Cleared by ignoreAllocations() on threads whose allocations are not part of the measurement,
+// such as a background writer running alongside the timed readers.
+thread_local bool countAllocations = true;
+
+void ignoreAllocations(){
+    countAllocations = false;
+}
+
+// Stream buffer that discards everything; used to silence functions that print their results.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+class SilenceCout {
+private:
+    NullBuffer sink;
+    std::streambuf* saved;
+
+public:
+    SilenceCout() : saved(std::cout.rdbuf(&sink)) {}
+    ~SilenceCout() { std::cout.rdbuf(saved); }
+};
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+void keep(const T& value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+double percentile(const std::vector<double>& sorted, double p){
+    if(sorted.empty()) return 0;
+    size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1) + 0.5));
+    return sorted[rank];
+}
+
+void printHeader(const std::string& title){
+    std::printf("\n== %s ==\n", title.c_str());
+    std::printf("%-44s %8s %12s %10s %10s %10s %10s %10s %12s\n",
+        "benchmark", "iters", "items/s", "p50 us", "p90 us", "p99 us", "max us", "allocs/it", "bytes/it");
+}
+
+// Runs op iterations times after one untimed warm-up call; items is the work done per call.
+template <typename Op>
+void run(const std::string& name, size_t iterations, double items, Op&& op){
+    op();
+
+    std::vector<double> micros;
+    micros.reserve(iterations);
+    size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    size_t bytesBefore = allocationBytes.load(std::memory_order_relaxed);
+
+    double total = 0;
+    for(size_t i = 0; i < iterations; i++){
+        auto start = std::chrono::steady_clock::now();
+        op();
+        auto stop = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::micro>(stop - start).count();
+        micros.push_back(elapsed);
+        total += elapsed;
+    }
+
+    double allocations = double(allocationCount.load(std::memory_order_relaxed) - allocationsBefore) / iterations;
+    double bytes = double(allocationBytes.load(std::memory_order_relaxed) - bytesBefore) / iterations;
+    std::sort(micros.begin(), micros.end());
+    double throughput = total > 0 ? items * iterations / (total / 1e6) : 0;
+
+    std::printf("%-44s %8zu %12.4g %10.2f %10.2f %10.2f %10.2f %10.1f %12.0f\n",
+        name.c_str(), iterations, throughput, percentile(micros, 0.50), percentile(micros, 0.90),
+        percentile(micros, 0.99), micros.back(), allocations, bytes);
+    std::fflush(stdout);
+}
+
+// Problem sizes scale with the first command line argument (default 1).
+double scaleFrom(int argc, char* argv[]){
+    double scale = argc > 1 ? std::atof(argv[1]) : 1.0;
+    return scale > 0 ? scale : 1.0;
+}
+
+}
+
+// Kept out of line: once inlined, GCC sees malloc paired with operator delete (and new with
+// free) at call sites and reports -Wmismatched-new-delete.
+__attribute__((noinline)) void* operator new(size_t size){
+    if(bench::countAllocations){
+        bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+        bench::allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if(void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size){
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete[](void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+#endif
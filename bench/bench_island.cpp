@@ -0,0 +1,88 @@
+// Benchmarks for hw5/island.cpp on random geometric island graphs.
+#include "bench.h"
+#include "generators.h"
+#include "../hw5/island.cpp"
+
+Graph buildGraph(const std::vector<generators::GeoPoint>& points, const std::vector<std::pair<int, int> >& edges){
+    IslandData data;
+    for(size_t i = 0; i < points.size(); i++){
+        data.names.push_back("Island " + std::to_string(i));
+        data.latitudes.push_back(points[i].latitude);
+        data.longitudes.push_back(points[i].longitude);
+        data.populations.push_back(50 + (i * 7919) % 451);
+    }
+
+    Graph graph(data);
+    for(const std::pair<int, int>& edge : edges){
+        graph.addRoute(edge.first, edge.second);
+        graph.addRoute(edge.second, edge.first);
+    }
+    return graph;
+}
+
+int main(int argc, char* argv[]){
+    double scale = bench::scaleFrom(argc, argv);
+    int islands = 20000 * scale;
+    std::vector<generators::GeoPoint> points = generators::randomIslands(islands, 311);
+    std::vector<std::pair<int, int> > edges = generators::geometricEdges(points, 0.6);
+
+    bench::printHeader("island: " + std::to_string(islands) + " islands, " + std::to_string(2 * edges.size()) + " routes");
+
+    bench::run("build graph (addRoute)", 5, 2.0 * edges.size(), [&](){
+        bench::keep(buildGraph(points, edges).size());
+    });
+
+    Graph graph = buildGraph(points, edges);
+    std::mt19937 rng(5);
+    auto randomSource = [&](){ return static_cast<int>(rng() % islands); };
+
+    bench::run("shareKnowledge (shortestPaths)", 50, islands, [&](){
+        bench::keep(shortestPaths(graph, randomSource()).order.size());
+    });
+
+    bench::run("specialResource (spanningTree)", 50, islands, [&](){
+        bench::keep(spanningTree(graph, randomSource()).edges.size());
+    });
+
+    bench::run("shareKnowledge + report", 20, islands, [&](){
+        std::ostringstream out;
+        reportKnowledge(out, graph, shortestPaths(graph, randomSource()));
+        bench::keep(out.tellp());
+    });
+
+    bench::run("weightedRoutes", 50, islands, [&](){
+        bench::keep(weightedRoutes(graph, randomSource(), CriteriaWeights{1.0, 10.0, 0.1}).cost.size());
+    });
+
+    std::vector<CriteriaWeights> weightings;
+    for(int k = 0; k < 32; k++) weightings.push_back({1.0, 5.0 * k, 0.05 * k});
+    bench::run("weightedRoutes x32 (parallel)", 5, 32.0 * islands, [&](){
+        bench::keep(weightedRoutes(graph, randomSource(), weightings).size());
+    });
+
+    ParetoOptions options;
+    options.maxHops = 8;
+    options.maxLabelsPerIsland = 16;
+    bench::run("paretoRoutes (8 hops, 16 labels)", 5, islands, [&](){
+        bench::keep(paretoRoutes(graph, randomSource(), options).labels.size());
+    });
+
+    std::string snapshotPath = "bench_island.snapshot";
+    std::string error;
+    bench::run("writeSnapshot", 5, islands, [&](){
+        bench::keep(graph.writeSnapshot(snapshotPath, error));
+    });
+
+    bench::run("GraphSnapshot::open", 50, islands, [&](){
+        GraphSnapshot snapshot;
+        bench::keep(snapshot.open(snapshotPath, error));
+    });
+
+    GraphSnapshot snapshot;
+    snapshot.open(snapshotPath, error);
+    bench::run("shortestPaths on snapshot", 50, islands, [&](){
+        bench::keep(shortestPaths(snapshot, randomSource()).order.size());
+    });
+    std::remove(snapshotPath.c_str());
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Benchmarks for hw7/messages.cpp: routing on power-law social graphs, run-length encoding and RSA.
+#include "bench.h"
+#include "generators.h"
+#include "../hw7/messages.cpp"
+
+#include <random>
+
+std::string runsOf(size_t length, unsigned seed){
+    std::mt19937 rng(seed);
+    std::string text;
+    while(text.size() < length){
+        text.append(1 + rng() % 12, static_cast<char>('A' + rng() % 26));
+    }
+    text.resize(length);
+    return text;
+}
+
+int main(int argc, char* argv[]){
+    double scale = bench::scaleFrom(argc, argv);
+    int users = 50000 * scale;
+    std::vector<std::pair<int, int> > edges = generators::powerLawGraph(users, 3, 311);
+
+    std::vector<std::string> names;
+    for(int i = 0; i < users; i++) names.push_back("user" + std::to_string(i));
+
+    bench::printHeader("messages: " + std::to_string(users) + " users, " + std::to_string(edges.size()) + " connections");
+
+    Graph network;
+    bench::run("build network (addUser/addEdge)", 3, edges.size(), [&](){
+        Graph built;
+        for(const std::string& name : names) built.addUser(name);
+        for(const std::pair<int, int>& edge : edges) built.addEdge(names[edge.first], names[edge.second]);
+        network = std::move(built);
+    });
+
+    std::mt19937 rng(9);
+    bench::run("breadthFirstSearch", 50, users, [&](){
+        bench::keep(breadthFirstSearch(network, names[rng() % users], names[rng() % users]).size());
+    });
+
+    std::string shortText = runsOf(64, 1);
+    std::string longText = runsOf(1 << 20, 2);
+    bench::run("runLengthEncoding (64 B)", 20000, 64, [&](){
+        bench::keep(runLengthEncoding(shortText).size());
+    });
+    bench::run("runLengthEncoding (1 MiB)", 20, longText.size(), [&](){
+        bench::keep(runLengthEncoding(longText).size());
+    });
+
+    auto keys = rsaKeys(11, 13);
+    std::string message = "Is mayonnaise a DSA? " + runsOf(4096, 3);
+    std::vector<int> encrypted = rsaEncryption(message, keys.first);
+    bench::run("rsaKeys(11, 13)", 2000, 1, [&](){
+        bench::keep(rsaKeys(11, 13).first.first);
+    });
+    bench::run("rsaEncryption (4 KiB)", 500, message.size(), [&](){
+        bench::keep(rsaEncryption(message, keys.first).size());
+    });
+    bench::run("rsaDecryption (4 KiB)", 500, encrypted.size(), [&](){
+        bench::keep(rsaDecryption(encrypted, keys.second).size());
+    });
+    bench::run("sign + verify (4 KiB)", 500, message.size(), [&](){
+        bench::keep(verify(message, std::stoi(sign(message, keys.second)), keys.first));
+    });
+    bench::run("modulusExp", 100000, 1, [&](){
+        bench::keep(modulusExp(rng() % 143, keys.second.first, keys.second.second));
+    });
+    return 0;
+}
@@ -0,0 +1,256 @@
+// Benchmarks for hw2/olelo.cpp on a synthetic corpus of sayings.
+#include "bench.h"
+#include "generators.h"
+#include "../hw2/olelo.cpp"
+
+#include <random>
+#include <thread>
+
+void insertAll(RedBlackTree& tree, const std::vector<generators::Saying>& corpus){
+   for(size_t i = 0; i < corpus.size(); i++){
+      tree.insert(i, corpus[i].olelo, corpus[i].english, corpus[i].explanation);
+   }
+}
+
+void insertAll(EytzingerIndex& index, const std::vector<generators::Saying>& corpus){
+   for(size_t i = 0; i < corpus.size(); i++){
+      index.append(i, corpus[i].olelo, corpus[i].english, corpus[i].explanation);
+   }
+   index.build();
+}
+
+// Packs random query keys into one buffer so the benchmark measures the index, not the
+// cache misses of fetching each query string from the corpus.
+struct QueryBatch {
+   std::string text;
+   std::vector<std::string_view> keys;
+
+   QueryBatch(const std::vector<generators::Saying>& corpus, size_t count, bool hits, unsigned seed){
+      std::mt19937 rng(seed);
+      std::vector<std::pair<size_t, size_t> > spans;
+      for(size_t i = 0; i < count; i++){
+         const generators::Saying& saying = corpus[rng() % corpus.size()];
+         const std::string& key = hits ? saying.olelo : saying.english;
+         spans.push_back({text.size(), key.size()});
+         text += key;
+      }
+      for(const std::pair<size_t, size_t>& span : spans){
+         keys.push_back(std::string_view(text.data() + span.first, span.second));
+      }
+   }
+};
+
+// Lookup cost of each ordered layout on a corpus too large for the CPU caches.
+template <typename Index>
+void benchLayout(const std::string& name, const std::vector<generators::Saying>& corpus){
+   bench::run(name + " load", 3, corpus.size(), [&](){
+      Index index;
+      insertAll(index, corpus);
+   });
+
+   Index index;
+   insertAll(index, corpus);
+   QueryBatch hits(corpus, 10000, true, 11);
+   QueryBatch misses(corpus, 10000, false, 12);
+
+   bench::run(name + " member (hit) x10k", 50, hits.keys.size(), [&](){
+      size_t found = 0;
+      for(std::string_view key : hits.keys) found += index.member(key);
+      bench::keep(found);
+   });
+   bench::run(name + " member (miss) x10k", 50, misses.keys.size(), [&](){
+      size_t found = 0;
+      for(std::string_view key : misses.keys) found += index.member(key);
+      bench::keep(found);
+   });
+   bench::run(name + " successor x10k", 50, hits.keys.size(), [&](){
+      size_t found = 0;
+      for(std::string_view key : hits.keys) found += index.successor(key).has_value();
+      bench::keep(found);
+   });
+   std::printf("%s memory: %.1f bytes per saying\n", name.c_str(), double(index.memoryUsage()) / corpus.size());
+}
+
+// Aggregate member() throughput of reader threads on a ConcurrentSayings while a writer
+// inserts and publishes a new version every millisecond. Each publish rebuilds the whole
+// version, O(n) in the corpus (see "ConcurrentSayings publish" below), so at this corpus size
+// the writer is rebuilding almost continuously and keeps one core busy.
+void benchConcurrentReads(const std::vector<generators::Saying>& corpus, int threads){
+   std::vector<Saying> records;
+   for(size_t i = 0; i < corpus.size(); i++){
+      records.push_back({static_cast<int>(i), corpus[i].olelo, corpus[i].english, corpus[i].explanation});
+   }
+   ConcurrentSayings dictionary(threads, std::move(records));
+   QueryBatch hits(corpus, 20000, true, 13);
+
+   // The writer's allocations are not counted, and the readers are started once, outside the
+   // timed region; each timed call releases one round of lookups and waits for all of them.
+   std::atomic<bool> done(false);
+   std::thread writer([&](){
+      bench::ignoreAllocations();
+      for(int next = 0; !done; next++){
+         dictionary.insert({static_cast<int>(corpus.size()) + next, "writer " + std::to_string(next), "", ""});
+         dictionary.publish();
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+   });
+
+   std::atomic<int> round(0);
+   std::atomic<int> finished(0);
+   std::vector<std::thread> readers;
+   for(int reader = 0; reader < threads; reader++){
+      readers.emplace_back([&, reader](){
+         for(int seen = 0; ; seen++){
+            while(round.load() == seen && !done){
+               std::this_thread::yield();
+            }
+            if(done) return;
+            size_t found = 0;
+            for(std::string_view key : hits.keys){
+               found += dictionary.read(reader, [key](const RedBlackTree& tree){ return tree.member(key); });
+            }
+            bench::keep(found);
+            finished.fetch_add(1);
+         }
+      });
+   }
+
+   bench::run("ConcurrentSayings member x20k, " + std::to_string(threads) + " readers", 20, threads * hits.keys.size(), [&](){
+      int target = (round.fetch_add(1) + 1) * threads;
+      while(finished.load() < target){
+         std::this_thread::yield();
+      }
+   });
+
+   done = true;
+   for(std::thread& reader : readers){
+      reader.join();
+   }
+   writer.join();
+}
+
+int main(int argc, char* argv[]){
+   double scale = bench::scaleFrom(argc, argv);
+   int sayings = 5000 * scale;
+   std::vector<generators::Saying> corpus = generators::sayingCorpus(sayings, 311);
+
+   bench::printHeader("olelo: " + std::to_string(sayings) + " sayings");
+
+   bench::run("RedBlackTree insert (whole corpus)", 3, sayings, [&](){
+      RedBlackTree tree;
+      insertAll(tree, corpus);
+   });
+
+   bench::run("RedBlackTree bulk load (whole corpus)", 3, sayings, [&](){
+      std::vector<Saying> records;
+      records.reserve(corpus.size());
+      for(size_t i = 0; i < corpus.size(); i++){
+         records.push_back({static_cast<int>(i), corpus[i].olelo, corpus[i].english, corpus[i].explanation});
+      }
+      RedBlackTree tree(std::move(records));
+   });
+
+   std::string corpusPath = "/tmp/bench_olelo.txt";
+   {
+      std::ofstream out(corpusPath);
+      for(const generators::Saying& saying : corpus){
+         out << "H " << saying.olelo << "\nE " << saying.english << "\nD " << saying.explanation << "\n";
+      }
+   }
+   bench::run("parseSayings + bulk load (mapped file)", 3, sayings, [&](){
+      MappedFile file(corpusPath);
+      std::vector<SayingView> records;
+      std::string error;
+      parseSayings(corpusPath, file, [&records](const SayingView& saying){ records.push_back(saying); }, error);
+      RedBlackTree tree(std::move(records));
+   });
+   std::remove(corpusPath.c_str());
+
+   RedBlackTree tree;
+   insertAll(tree, corpus);
+   std::mt19937 rng(7);
+
+   bench::run("RedBlackTree member (hit)", 20000, 1, [&](){
+      bench::keep(tree.member(corpus[rng() % sayings].olelo));
+   });
+
+   bench::run("RedBlackTree member (miss)", 20000, 1, [&](){
+      bench::keep(tree.member(corpus[rng() % sayings].english));
+   });
+
+   bench::run("RedBlackTree successor", 20000, 1, [&](){
+      bench::keep(tree.successor(corpus[rng() % sayings].olelo).has_value());
+   });
+
+   std::string frequentWord = corpus[0].olelo.substr(0, corpus[0].olelo.find(' '));
+   bench::run("sayingsWith (frequent word)", 2000, 1, [&](){
+      bench::keep(tree.sayingsWith(frequentWord).size());
+   });
+
+   bench::run("translationsWith (\"the\")", 2000, 1, [&](){
+      bench::keep(tree.translationsWith("the").size());
+   });
+
+   bench::run("translationsWith (unknown word)", 20000, 1, [&](){
+      bench::keep(tree.translationsWith("mayonnaise").size());
+   });
+
+   bench::run("search (the AND sea, top 10)", 2000, 1, [&](){
+      bench::keep(tree.searchTranslations("the AND sea", 10).size());
+   });
+
+   bench::run("search (the AND stranger, top 10)", 2000, 1, [&](){
+      bench::keep(tree.searchTranslations("the AND stranger", 10).size());
+   });
+
+   bench::run("search ((sea OR wave) -the, top 10)", 2000, 1, [&](){
+      bench::keep(tree.searchTranslations("(sea OR wave) -the", 10).size());
+   });
+
+   bench::run("search (\"the sea\", top 10)", 2000, 1, [&](){
+      bench::keep(tree.searchTranslations("\"the sea\"", 10).size());
+   });
+
+   std::string typed = foldHawaiian(corpus[1].olelo).substr(0, 8);
+   bench::run("complete (8-char prefix, top 10)", 20000, 1, [&](){
+      bench::keep(tree.complete(typed, 10).size());
+   });
+
+   bench::run("complete (8-char prefix, 1 edit, top 10)", 2000, 1, [&](){
+      bench::keep(tree.complete(typed.substr(1), 10, 1).size());
+   });
+
+   bench::run("findSimilar (whole saying, 2 edits)", 2000, 1, [&](){
+      bench::keep(tree.findSimilar(foldHawaiian(corpus[rng() % sayings].olelo).substr(1), 2, 10).size());
+   });
+
+   std::printf("folded trie: %.1f bytes per saying\n", double(tree.foldedIndex().memoryUsage()) / sayings);
+   std::printf("word indexes: %zu + %zu terms, %.1f bytes per saying\n", tree.oleloWords().termCount(), tree.englishWords().termCount(),
+      double(tree.oleloWords().memoryUsage() + tree.englishWords().memoryUsage()) / sayings);
+
+   {
+      std::vector<Saying> records;
+      for(size_t i = 0; i < corpus.size(); i++){
+         records.push_back({static_cast<int>(i), corpus[i].olelo, corpus[i].english, corpus[i].explanation});
+      }
+      ConcurrentSayings dictionary(1, std::move(records));
+      int next = 0;
+      bench::run("ConcurrentSayings publish (1 insert)", 20, 1, [&](){
+         dictionary.insert({sayings + next, "publish " + std::to_string(next), "", ""});
+         next++;
+         dictionary.publish();
+      });
+   }
+
+   int hardware = std::max(1u, std::thread::hardware_concurrency());
+   for(int threads = 1; threads <= hardware; threads *= 2){
+      benchConcurrentReads(corpus, threads);
+   }
+
+   int large = 200000 * scale;
+   std::vector<generators::Saying> largeCorpus = generators::sayingCorpus(large, 313);
+   bench::printHeader("olelo layouts: " + std::to_string(large) + " sayings");
+   benchLayout<RedBlackTree>("RedBlackTree", largeCorpus);
+   benchLayout<EytzingerIndex>("EytzingerIndex", largeCorpus);
+   return 0;
+}
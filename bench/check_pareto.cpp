@@ -0,0 +1,97 @@
+// Checks paretoRoutes against brute-force enumeration of every simple route on small random
+// graphs: each island's reported front must be exactly its set of non-dominated
+// (distance, hops, coverage) triples, each reported route must be a real simple route, and
+// weightedChoice must pick a route scoring as well as the best of them all.
+#include "../hw5/island.cpp"
+
+#include <cstdio>
+#include <random>
+#include <set>
+#include <tuple>
+
+typedef std::tuple<long long, int, long long> Criteria;
+
+void enumerate(const Graph& graph, int island, std::vector<bool>& used, Criteria at, std::vector<std::vector<Criteria> >& found){
+    found[island].push_back(at);
+    for(const Route& route : graph.routes(island)){
+        if(used[route.to]) continue;
+        used[route.to] = true;
+        enumerate(graph, route.to, used, Criteria(std::get<0>(at) + route.distance, std::get<1>(at) + 1, std::get<2>(at) + graph.population(route.to)), found);
+        used[route.to] = false;
+    }
+}
+
+std::set<Criteria> nonDominated(const std::vector<Criteria>& all){
+    std::set<Criteria> front;
+    for(const Criteria& a : all){
+        bool beaten = false;
+        for(const Criteria& b : all){
+            bool noWorse = std::get<0>(b) <= std::get<0>(a) && std::get<1>(b) <= std::get<1>(a) && std::get<2>(b) >= std::get<2>(a);
+            if(noWorse && b != a) beaten = true;
+        }
+        if(!beaten) front.insert(a);
+    }
+    return front;
+}
+
+int main(){
+    std::mt19937 rng(311);
+    int wrongIslands = 0;
+    int checkedIslands = 0;
+    for(int trial = 0; trial < 500; trial++){
+        int n = 3 + rng() % 6;
+        Graph graph(n);
+        for(int i = 0; i < n; i++){
+            graph.addIsland(i, "Island " + std::to_string(i), 1 + rng() % 20);
+        }
+        for(int u = 0; u < n; u++){
+            for(int v = 0; v < n; v++){
+                if(u != v && rng() % 2 == 0) graph.addRoute(u, v, 1 + rng() % 10);
+            }
+        }
+
+        int source = rng() % n;
+        ParetoFront pareto = paretoRoutes(graph, source);
+        std::vector<std::vector<Criteria> > found(n);
+        std::vector<bool> used(n, false);
+        used[source] = true;
+        enumerate(graph, source, used, Criteria(0, 0, graph.population(source)), found);
+
+        for(int island = 0; island < n; island++){
+            std::set<Criteria> reported;
+            bool valid = true;
+            for(int label : pareto.front[island]){
+                const ParetoLabel& l = pareto.labels[label];
+                reported.insert(Criteria(l.distance, l.hops, l.coverage));
+
+                std::vector<int> route = routeOf(pareto, label);
+                std::set<int> distinct(route.begin(), route.end());
+                long long coverage = 0;
+                for(int stop : route) coverage += graph.population(stop);
+                valid = valid && distinct.size() == route.size() && route.front() == source && route.back() == island
+                    && static_cast<int>(route.size()) == l.hops + 1 && coverage == l.coverage;
+            }
+            CriteriaWeights weights = {double(rng() % 4), double(rng() % 4), double(rng() % 4)};
+            int chosen = weightedChoice(pareto, island, weights);
+            double best = std::numeric_limits<double>::infinity();
+            for(const Criteria& c : found[island]){
+                best = std::min(best, weights.distance * std::get<0>(c) + weights.hops * std::get<1>(c) - weights.population * std::get<2>(c));
+            }
+            if(chosen == -1){
+                valid = valid && found[island].empty();
+            }
+            else{
+                const ParetoLabel& l = pareto.labels[chosen];
+                valid = valid && weights.distance * l.distance + weights.hops * l.hops - weights.population * l.coverage == best;
+            }
+
+            checkedIslands++;
+            if(!valid || reported.size() != pareto.front[island].size() || reported != nonDominated(found[island])){
+                wrongIslands++;
+            }
+        }
+    }
+
+    std::printf("paretoRoutes: %d of %d island fronts wrong\n", wrongIslands, checkedIslands);
+    return wrongIslands == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// Checks RedBlackTree::searchTranslations against brute-force evaluation of random queries on
+// small random corpora: every query's full result must be exactly the matching documents, and
+// its top 5 the first five of that result. Queries nest AND, OR, NOT, '-' and phrases, with
+// negations stacked several deep, and some terms span more than one posting block.
+#include "../hw2/olelo.cpp"
+
+#include <cstdio>
+#include <random>
+#include <set>
+
+const char* vocabulary[] = {"a", "b", "c", "d", "e"};
+
+struct Query {
+   std::string text;
+   std::function<bool(const std::vector<std::string>&)> matches;
+};
+
+bool hasWord(const std::vector<std::string>& words, const std::string& word){
+   return std::find(words.begin(), words.end(), word) != words.end();
+}
+
+// Composite children are always parenthesized, so the text never leans on precedence.
+Query randomQuery(std::mt19937& rng, int depth){
+   int kind = depth == 0 ? rng() % 2 : rng() % 6;
+   if(kind == 0){
+      std::string word = vocabulary[rng() % 5];
+      return Query{word, [word](const std::vector<std::string>& words){ return hasWord(words, word); }};
+   }
+   if(kind == 1){
+      std::vector<std::string> phrase = {vocabulary[rng() % 5], vocabulary[rng() % 5]};
+      return Query{"\"" + phrase[0] + " " + phrase[1] + "\"", [phrase](const std::vector<std::string>& words){
+         return std::search(words.begin(), words.end(), phrase.begin(), phrase.end()) != words.end();
+      }};
+   }
+
+   Query left = randomQuery(rng, depth - 1);
+   std::string leftText = "(" + left.text + ")";
+   if(kind == 2 || kind == 3){
+      return Query{(kind == 2 ? "NOT " : "-") + leftText, [left](const std::vector<std::string>& words){ return !left.matches(words); }};
+   }
+
+   Query right = randomQuery(rng, depth - 1);
+   std::string rightText = "(" + right.text + ")";
+   if(kind == 4){
+      return Query{leftText + (rng() % 2 ? " AND " : " ") + rightText, [left, right](const std::vector<std::string>& words){
+         return left.matches(words) && right.matches(words);
+      }};
+   }
+   return Query{leftText + " OR " + rightText, [left, right](const std::vector<std::string>& words){
+      return left.matches(words) || right.matches(words);
+   }};
+}
+
+int main(){
+   std::mt19937 rng(311);
+   int wrong = 0;
+   int checked = 0;
+   for(int trial = 0; trial < 40; trial++){
+      int count = trial % 2 == 0 ? 6 + rng() % 20 : 300 + rng() % 400;
+      std::vector<Saying> corpus;
+      std::vector<std::vector<std::string> > texts(count);
+      for(int doc = 0; doc < count; doc++){
+         std::string english;
+         int length = 1 + rng() % 4;
+         for(int i = 0; i < length; i++){
+            texts[doc].push_back(vocabulary[rng() % 5]);
+            english += (i == 0 ? "" : " ") + texts[doc].back();
+         }
+         corpus.push_back({doc, "saying " + std::to_string(doc), english, ""});
+      }
+      RedBlackTree tree(corpus);
+
+      for(int q = 0; q < 100; q++){
+         Query query = randomQuery(rng, 1 + rng() % 4);
+         std::set<int> expected;
+         for(int doc = 0; doc < count; doc++){
+            if(query.matches(texts[doc])) expected.insert(doc);
+         }
+
+         std::vector<SayingView> all = tree.searchTranslations(query.text, count);
+         std::vector<SayingView> top = tree.searchTranslations(query.text, 5);
+         std::set<int> found;
+         for(const SayingView& hit : all) found.insert(hit.data);
+         bool ok = found == expected && found.size() == all.size() && top.size() == std::min<size_t>(5, all.size());
+         for(size_t i = 0; ok && i < top.size(); i++){
+            ok = top[i].data == all[i].data;
+         }
+
+         checked++;
+         if(!ok){
+            if(wrong < 5) std::printf("wrong: %s (%zu found, %zu expected)\n", query.text.c_str(), found.size(), expected.size());
+            wrong++;
+         }
+      }
+   }
+
+   std::printf("searchTranslations: %d of %d queries wrong\n", wrong, checked);
+   return wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// Deterministic synthetic inputs for the benchmarks: power-law social graphs, random geometric
+// island graphs and corpora of ʻōlelo-style sayings.
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace generators {
+
+// Barabási–Albert preferential attachment: each new vertex links to edgesPerVertex existing
+// vertices chosen proportionally to their degree, giving a power-law degree distribution.
+std::vector<std::pair<int, int> > powerLawGraph(int vertices, int edgesPerVertex, unsigned seed){
+    std::mt19937 rng(seed);
+    std::vector<std::pair<int, int> > edges;
+    std::vector<int> endpoints;
+    int core = std::max(2, edgesPerVertex);
+
+    for(int u = 0; u < core && u < vertices; u++){
+        for(int v = 0; v < u; v++){
+            edges.push_back({u, v});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+
+    for(int u = core; u < vertices; u++){
+        std::vector<int> targets;
+        while(static_cast<int>(targets.size()) < edgesPerVertex){
+            int v = endpoints[std::uniform_int_distribution<size_t>(0, endpoints.size() - 1)(rng)];
+            if(std::find(targets.begin(), targets.end(), v) == targets.end()) targets.push_back(v);
+        }
+        for(int v : targets){
+            edges.push_back({u, v});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return edges;
+}
+
+struct GeoPoint {
+    double latitude;
+    double longitude;
+};
+
+// Uniform points in a latitude/longitude box roughly the size of the Pacific island region.
+std::vector<GeoPoint> randomIslands(int count, unsigned seed){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> latitude(-180.0, -130.0);
+    std::uniform_real_distribution<double> longitude(-30.0, 25.0);
+    std::vector<GeoPoint> points(count);
+    for(GeoPoint& point : points){
+        point.latitude = latitude(rng);
+        point.longitude = longitude(rng);
+    }
+    return points;
+}
+
+// Random geometric graph: connects every pair closer than radius degrees, using a uniform grid
+// so generation stays near-linear in the number of points.
+std::vector<std::pair<int, int> > geometricEdges(const std::vector<GeoPoint>& points, double radius){
+    std::unordered_map<long long, std::vector<int> > grid;
+    auto cell = [radius](double value){ return static_cast<long long>(std::floor(value / radius)); };
+    auto key = [](long long x, long long y){ return x * 1000003LL + y; };
+
+    for(size_t i = 0; i < points.size(); i++){
+        grid[key(cell(points[i].latitude), cell(points[i].longitude))].push_back(i);
+    }
+
+    std::vector<std::pair<int, int> > edges;
+    for(size_t i = 0; i < points.size(); i++){
+        long long x = cell(points[i].latitude);
+        long long y = cell(points[i].longitude);
+        for(long long dx = -1; dx <= 1; dx++){
+            for(long long dy = -1; dy <= 1; dy++){
+                auto found = grid.find(key(x + dx, y + dy));
+                if(found == grid.end()) continue;
+                for(int j : found->second){
+                    double a = points[i].latitude - points[j].latitude;
+                    double b = points[i].longitude - points[j].longitude;
+                    if(j > static_cast<int>(i) && a * a + b * b <= radius * radius){
+                        edges.push_back({static_cast<int>(i), j});
+                    }
+                }
+            }
+        }
+    }
+    return edges;
+}
+
+struct Saying {
+    std::string olelo;
+    std::string english;
+    std::string explanation;
+};
+
+// Sayings built from Hawaiian syllables (with ʻokina and kahakō) and a small English lexicon.
+// Word frequencies follow a Zipf-like distribution so inverted-index postings are skewed.
+std::vector<Saying> sayingCorpus(int count, unsigned seed){
+    static const char* const syllables[] = {
+        "ka", "ke", "ki", "ko", "ku", "la", "le", "li", "lo", "lu", "ma", "me", "mi", "mo", "mu",
+        "na", "ne", "ni", "no", "nu", "pa", "pe", "pi", "po", "pu", "ha", "he", "hi", "ho", "hu",
+        "wa", "we", "wi", "ʻa", "ʻe", "ʻi", "ʻo", "ʻu", "ā", "ē", "ī", "ō", "ū", "lā", "nō", "kū"
+    };
+    static const char* const english[] = {
+        "the", "a", "of", "to", "and", "in", "is", "one", "sea", "land", "canoe", "paddle", "work",
+        "family", "rain", "wind", "sky", "chief", "stranger", "day", "night", "fish", "taro", "water",
+        "mountain", "wave", "star", "light", "child", "love", "path", "voice", "heart", "strive"
+    };
+    const int syllableCount = sizeof(syllables) / sizeof(syllables[0]);
+    const int englishCount = sizeof(english) / sizeof(english[0]);
+
+    std::mt19937 rng(seed);
+    std::vector<std::string> vocabulary;
+    for(int i = 0; i < 4000; i++){
+        std::string word;
+        int length = 1 + rng() % 3;
+        for(int s = 0; s < length; s++) word += syllables[rng() % syllableCount];
+        vocabulary.push_back(word);
+    }
+
+    auto zipf = [&rng](int size){
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return std::min(size - 1, static_cast<int>(std::pow(size, u)) - 1);
+    };
+    auto sentence = [&](int words, bool hawaiian){
+        std::string text;
+        for(int w = 0; w < words; w++){
+            if(w > 0) text += ' ';
+            text += hawaiian ? vocabulary[zipf(vocabulary.size())] : english[zipf(englishCount)];
+        }
+        if(!text.empty() && text[0] >= 'a' && text[0] <= 'z') text[0] -= 'a' - 'A';
+        return text;
+    };
+
+    std::vector<Saying> corpus(count);
+    for(Saying& saying : corpus){
+        saying.olelo = sentence(3 + rng() % 6, true);
+        saying.english = sentence(4 + rng() % 6, false);
+        saying.explanation = sentence(5 + rng() % 8, false);
+    }
+    return corpus;
+}
+
+}
+
+#endif
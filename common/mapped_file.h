@@ -0,0 +1,110 @@
+// Read-only file mapping and line scanning shared by the homework programs' loaders.
+//
+// Loaders map the whole input, walk it with nextLine, and parse fields straight out of the
+// mapping as string_views, so no line is ever copied. Errors name the file and line through
+// lineError. Needs C++17 (string_view) and POSIX mmap.
+#ifndef ICS311_MAPPED_FILE_H
+#define ICS311_MAPPED_FILE_H
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file; an empty file maps to an empty range.
+class MappedFile {
+private:
+    const char* bytes;
+    size_t length;
+    bool opened;
+
+public:
+    MappedFile() : bytes(nullptr), length(0), opened(false) {
+    }
+
+    explicit MappedFile(const std::string& path, int advice = MADV_SEQUENTIAL) : bytes(nullptr), length(0), opened(false) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0) return;
+
+        struct stat info;
+        if(fstat(fd, &info) == 0){
+            opened = true;
+            if(info.st_size > 0){
+                void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapped != MAP_FAILED){
+                    bytes = static_cast<const char*>(mapped);
+                    length = info.st_size;
+                    madvise(mapped, length, advice);
+                }
+                else{
+                    opened = false;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile(){
+        if(bytes != nullptr){
+            munmap(const_cast<char*>(bytes), length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept : bytes(other.bytes), length(other.length), opened(other.opened) {
+        other.bytes = nullptr;
+        other.length = 0;
+        other.opened = false;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if(this != &other){
+            if(bytes != nullptr){
+                munmap(const_cast<char*>(bytes), length);
+            }
+            bytes = other.bytes;
+            length = other.length;
+            opened = other.opened;
+            other.bytes = nullptr;
+            other.length = 0;
+            other.opened = false;
+        }
+        return *this;
+    }
+
+    bool isOpen() const { return opened; }
+    const char* begin() const { return bytes; }
+    const char* end() const { return bytes + length; }
+    size_t size() const { return length; }
+};
+
+// Returns the line starting at cursor without its "\n" or "\r\n" and moves cursor past it.
+inline std::string_view nextLine(const char*& cursor, const char* end){
+    const char* start = cursor;
+    const char* newline = static_cast<const char*>(memchr(start, '\n', end - start));
+    const char* stop = newline != nullptr ? newline : end;
+    cursor = newline != nullptr ? newline + 1 : end;
+    if(stop > start && stop[-1] == '\r') stop--;
+    return std::string_view(start, stop - start);
+}
+
+// Lines nextLine will return, counting a final line without a newline.
+inline size_t countLines(const MappedFile& file){
+    size_t lines = std::count(file.begin(), file.end(), '\n');
+    if(file.size() > 0 && file.end()[-1] != '\n') lines++;
+    return lines;
+}
+
+// "path:line: message", the form every loader reports errors in.
+inline std::string lineError(const std::string& path, size_t line, const std::string& message){
+    return path + ":" + std::to_string(line) + ": " + message;
+}
+
+#endif
@@ -0,0 +1,312 @@
+// Hot-path counters and histograms shared by the homework programs.
+//
+// Everything here is compiled out unless ICS311_METRICS is defined (make METRICS=-DICS311_METRICS):
+// the METRIC_* macros then expand to empty statements and the programs are unchanged. When it is
+// defined, each thread records into its own block of relaxed atomics, so recording never
+// contends. When a thread exits its block is folded into one shared retired block and freed, so
+// a snapshot sums the live threads' blocks and the retired one, and memory stays bounded by
+// the threads alive at once. METRICS_DUMP_AT_EXIT() prints that snapshot to stderr when the program
+// exits, as JSON, or in the Prometheus text format if ICS311_METRICS_FORMAT=prometheus.
+//
+// Histograms use power-of-two buckets: bucket b counts the values of bit width b, so bucket 0
+// holds 0 and bucket b > 0 holds [2^(b-1), 2^b). The header sticks to C++11 for hw7.
+#ifndef ICS311_METRICS_H
+#define ICS311_METRICS_H
+
+#ifdef ICS311_METRICS
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+
+const size_t maxCounters = 32;
+const size_t maxHistograms = 16;
+const size_t bucketCount = 65;
+
+struct Histogram {
+    std::atomic<uint64_t> buckets[bucketCount];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+};
+
+// One per recording thread; only its owner writes it, snapshots read it concurrently.
+struct ThreadBlock {
+    std::atomic<uint64_t> counters[maxCounters];
+    Histogram histograms[maxHistograms];
+};
+
+struct Registry {
+    std::mutex lock;
+    std::vector<std::string> counterNames;
+    std::vector<std::string> histogramNames;
+    std::vector<ThreadBlock*> threads;
+    ThreadBlock retired;
+};
+
+// Never destroyed, so the dump registered with atexit can still read it.
+inline Registry& registry(){
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+inline size_t registerName(std::vector<std::string>& names, const char* name, size_t limit){
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for(size_t i = 0; i < names.size(); i++){
+        if(names[i] == name) return i;
+    }
+    if(names.size() == limit){
+        std::cerr << "metrics: no room to register " << name << std::endl;
+        std::abort();
+    }
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+inline size_t counterId(const char* name){
+    return registerName(registry().counterNames, name, maxCounters);
+}
+
+inline size_t histogramId(const char* name){
+    return registerName(registry().histogramNames, name, maxHistograms);
+}
+
+inline void fold(std::atomic<uint64_t>& into, const std::atomic<uint64_t>& from){
+    into.store(into.load(std::memory_order_relaxed) + from.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// Adds an exiting thread's counts to the retired block and frees its block.
+inline void retire(ThreadBlock* block){
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for(size_t i = 0; i < maxCounters; i++){
+        fold(r.retired.counters[i], block->counters[i]);
+    }
+    for(size_t i = 0; i < maxHistograms; i++){
+        for(size_t b = 0; b < bucketCount; b++){
+            fold(r.retired.histograms[i].buckets[b], block->histograms[i].buckets[b]);
+        }
+        fold(r.retired.histograms[i].count, block->histograms[i].count);
+        fold(r.retired.histograms[i].sum, block->histograms[i].sum);
+    }
+    r.threads.erase(std::find(r.threads.begin(), r.threads.end(), block));
+    delete block;
+}
+
+inline ThreadBlock* registerBlock(){
+    ThreadBlock* block = new ThreadBlock();
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.threads.push_back(block);
+    return block;
+}
+
+// Owns the calling thread's block and retires it when the thread exits.
+struct LocalBlock {
+    ThreadBlock* block;
+
+    LocalBlock() : block(registerBlock()) {
+    }
+
+    ~LocalBlock(){
+        retire(block);
+        exited() = true;
+    }
+
+    // Set once this thread's LocalBlock is gone; trivially destructible, so it outlives it.
+    static bool& exited(){
+        static thread_local bool flag = false;
+        return flag;
+    }
+};
+
+// A thread that records again after its block was retired, e.g. from an atexit handler, gets a
+// fresh block that is never freed.
+inline ThreadBlock& local(){
+    if(LocalBlock::exited()){
+        static thread_local ThreadBlock* late = nullptr;
+        if(late == nullptr) late = registerBlock();
+        return *late;
+    }
+    static thread_local LocalBlock holder;
+    return *holder.block;
+}
+
+// Single-writer increment: a plain load and store instead of a locked read-modify-write.
+inline void bump(std::atomic<uint64_t>& cell, uint64_t amount){
+    cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline void count(size_t id, uint64_t amount){
+    bump(local().counters[id], amount);
+}
+
+inline void record(size_t id, uint64_t value){
+    Histogram& histogram = local().histograms[id];
+    size_t bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+    bump(histogram.buckets[bucket], 1);
+    bump(histogram.count, 1);
+    bump(histogram.sum, value);
+}
+
+// Records the nanoseconds from construction to destruction.
+class ScopedTimer {
+private:
+    size_t id;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(size_t id) : id(id), start(std::chrono::steady_clock::now()) {
+    }
+
+    ~ScopedTimer(){
+        record(id, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+struct HistogramSnapshot {
+    std::string name;
+    uint64_t count;
+    uint64_t sum;
+    std::vector<uint64_t> buckets;
+};
+
+struct Snapshot {
+    std::vector<std::pair<std::string, uint64_t> > counters;
+    std::vector<HistogramSnapshot> histograms;
+};
+
+inline Snapshot snapshot(){
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    Snapshot result;
+    for(size_t i = 0; i < r.counterNames.size(); i++){
+        uint64_t total = r.retired.counters[i].load(std::memory_order_relaxed);
+        for(size_t t = 0; t < r.threads.size(); t++){
+            total += r.threads[t]->counters[i].load(std::memory_order_relaxed);
+        }
+        result.counters.push_back(std::make_pair(r.counterNames[i], total));
+    }
+    for(size_t i = 0; i < r.histogramNames.size(); i++){
+        HistogramSnapshot histogram;
+        histogram.name = r.histogramNames[i];
+        histogram.count = 0;
+        histogram.sum = 0;
+        histogram.buckets.assign(bucketCount, 0);
+        for(size_t t = 0; t <= r.threads.size(); t++){
+            const Histogram& source = t < r.threads.size() ? r.threads[t]->histograms[i] : r.retired.histograms[i];
+            histogram.count += source.count.load(std::memory_order_relaxed);
+            histogram.sum += source.sum.load(std::memory_order_relaxed);
+            for(size_t b = 0; b < bucketCount; b++){
+                histogram.buckets[b] += source.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+        result.histograms.push_back(histogram);
+    }
+    return result;
+}
+
+// Largest value that lands in bucket b.
+inline uint64_t bucketLimit(size_t b){
+    return b == 0 ? 0 : b == 64 ? UINT64_MAX : (uint64_t(1) << b) - 1;
+}
+
+// {"counters": {name: value}, "histograms": {name: {"count", "sum", "buckets": [{"le", "count"}]}}},
+// listing only non-empty buckets.
+inline void writeJson(std::ostream& out, const Snapshot& snapshot){
+    out << "{\"counters\": {";
+    for(size_t i = 0; i < snapshot.counters.size(); i++){
+        out << (i == 0 ? "" : ", ") << "\"" << snapshot.counters[i].first << "\": " << snapshot.counters[i].second;
+    }
+    out << "}, \"histograms\": {";
+    for(size_t i = 0; i < snapshot.histograms.size(); i++){
+        const HistogramSnapshot& histogram = snapshot.histograms[i];
+        out << (i == 0 ? "" : ", ") << "\"" << histogram.name << "\": {\"count\": " << histogram.count
+            << ", \"sum\": " << histogram.sum << ", \"buckets\": [";
+        bool first = true;
+        for(size_t b = 0; b < bucketCount; b++){
+            if(histogram.buckets[b] == 0) continue;
+            out << (first ? "" : ", ") << "{\"le\": " << bucketLimit(b) << ", \"count\": " << histogram.buckets[b] << "}";
+            first = false;
+        }
+        out << "]}";
+    }
+    out << "}}" << std::endl;
+}
+
+// Prometheus text exposition: counters as ics311_<name>_total, histograms with cumulative
+// buckets up to the highest non-empty one, then +Inf, _sum and _count.
+inline void writePrometheus(std::ostream& out, const Snapshot& snapshot){
+    for(size_t i = 0; i < snapshot.counters.size(); i++){
+        const std::string name = "ics311_" + snapshot.counters[i].first + "_total";
+        out << "# TYPE " << name << " counter\n" << name << " " << snapshot.counters[i].second << "\n";
+    }
+    for(size_t i = 0; i < snapshot.histograms.size(); i++){
+        const HistogramSnapshot& histogram = snapshot.histograms[i];
+        const std::string name = "ics311_" + histogram.name;
+        out << "# TYPE " << name << " histogram\n";
+        size_t highest = 0;
+        for(size_t b = 0; b < bucketCount; b++){
+            if(histogram.buckets[b] != 0) highest = b;
+        }
+        uint64_t cumulative = 0;
+        for(size_t b = 0; b <= highest && b < 64; b++){
+            cumulative += histogram.buckets[b];
+            out << name << "_bucket{le=\"" << bucketLimit(b) << "\"} " << cumulative << "\n";
+        }
+        out << name << "_bucket{le=\"+Inf\"} " << histogram.count << "\n";
+        out << name << "_sum " << histogram.sum << "\n";
+        out << name << "_count " << histogram.count << "\n";
+    }
+    out.flush();
+}
+
+inline void dump(){
+    const char* format = std::getenv("ICS311_METRICS_FORMAT");
+    if(format != nullptr && std::strcmp(format, "prometheus") == 0){
+        writePrometheus(std::cerr, snapshot());
+    }
+    else{
+        writeJson(std::cerr, snapshot());
+    }
+}
+
+inline void dumpAtExit(){
+    std::atexit(dump);
+}
+
+}
+
+#define METRICS_CONCAT_(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_(a, b)
+
+// Each call site resolves its metric id once, through a function-local static.
+#define METRIC_COUNT(name, amount) \
+    do { static const size_t metricId = ::metrics::counterId(name); ::metrics::count(metricId, (amount)); } while(0)
+#define METRIC_RECORD(name, value) \
+    do { static const size_t metricId = ::metrics::histogramId(name); ::metrics::record(metricId, (value)); } while(0)
+#define METRIC_TIME(name) \
+    static const size_t METRICS_CONCAT(metricTimerId, __LINE__) = ::metrics::histogramId(name); \
+    ::metrics::ScopedTimer METRICS_CONCAT(metricTimer, __LINE__)(METRICS_CONCAT(metricTimerId, __LINE__))
+#define METRICS_DUMP_AT_EXIT() ::metrics::dumpAtExit()
+
+#else
+
+#define METRIC_COUNT(name, amount) do { (void)sizeof(amount); } while(0)
+#define METRIC_RECORD(name, value) do { (void)sizeof(value); } while(0)
+#define METRIC_TIME(name) do {} while(0)
+#define METRICS_DUMP_AT_EXIT() do {} while(0)
+
+#endif
+
+#endif
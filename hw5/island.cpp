@@ -1,29 +1,602 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <queue>
 #include <limits>
-#include <stack>
 #include <fstream>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+#include "../common/mapped_file.h"
+#include "../common/metrics.h"
+
+double dtor(double deg){
+    return ((deg*M_PI)/180.0);
+}
+
+double haversine(double lat1, double lon1, double lat2, double lon2){
+    return (2*6371*asin(sqrt((pow((sin(dtor(lon1-lon2))/2), 2.0))+(pow((sin(dtor(lat1-lat2))/2), 2.0))*cos(dtor(lon1))*cos(dtor(lon2)))));
+}
+
+std::string_view trim(std::string_view text){
+    while(!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while(!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+bool parseNumber(std::string_view text, double& value){
+    text = trim(text);
+    if(!text.empty() && text.front() == '+') text.remove_prefix(1);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size() && !text.empty();
+}
+
+bool parseNumber(std::string_view text, int& value){
+    text = trim(text);
+    if(!text.empty() && text.front() == '+') text.remove_prefix(1);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size() && !text.empty();
+}
+
+// Splits off the text up to the next comma; the remainder is left in line.
+std::string_view nextField(std::string_view& line){
+    size_t comma = line.find(',');
+    std::string_view field = line.substr(0, comma);
+    line = comma == std::string_view::npos ? std::string_view() : line.substr(comma + 1);
+    return field;
+}
+
+// Columnar island data; populations stays empty when the input does not carry them.
+struct IslandData {
+    std::vector<std::string> names;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<int> populations;
+
+    int size() const { return names.size(); }
+};
+
+bool loadColumn(const std::string& path, std::vector<double>& column, std::string& error){
+    MappedFile file(path);
+    if(!file.isOpen()){
+        error = "cannot open " + path;
+        return false;
+    }
+
+    column.reserve(countLines(file));
+    const char* cursor = file.begin();
+    size_t lineNumber = 0;
+    while(cursor < file.end()){
+        std::string_view line = nextLine(cursor, file.end());
+        lineNumber++;
+        if(trim(line).empty()) continue;
+
+        double value;
+        if(!parseNumber(line, value)){
+            error = lineError(path, lineNumber, "expected a number");
+            return false;
+        }
+        column.push_back(value);
+    }
+    return true;
+}
+
+// Loads the islands.txt / lats.txt / longs.txt layout: one value per line, aligned by line.
+bool loadIslandFiles(const std::string& islandsPath, const std::string& latsPath, const std::string& longsPath, IslandData& data, std::string& error){
+    MappedFile file(islandsPath);
+    if(!file.isOpen()){
+        error = "cannot open " + islandsPath;
+        return false;
+    }
+
+    data.names.reserve(countLines(file));
+    const char* cursor = file.begin();
+    while(cursor < file.end()){
+        std::string_view line = nextLine(cursor, file.end());
+        if(!trim(line).empty()) data.names.emplace_back(line);
+    }
+
+    if(!loadColumn(latsPath, data.latitudes, error) || !loadColumn(longsPath, data.longitudes, error)){
+        return false;
+    }
+
+    if(data.latitudes.size() != data.names.size() || data.longitudes.size() != data.names.size()){
+        error = "island, latitude and longitude files have different lengths";
+        return false;
+    }
+    return true;
+}
+
+// Loads "name,latitude,longitude[,population]" lines; blank lines and lines starting with '#' are skipped.
+bool loadIslandCsv(const std::string& path, IslandData& data, std::string& error){
+    MappedFile file(path);
+    if(!file.isOpen()){
+        error = "cannot open " + path;
+        return false;
+    }
+
+    size_t lines = countLines(file);
+    data.names.reserve(lines);
+    data.latitudes.reserve(lines);
+    data.longitudes.reserve(lines);
+
+    const char* cursor = file.begin();
+    size_t lineNumber = 0;
+    bool hasPopulations = false;
+    while(cursor < file.end()){
+        std::string_view line = nextLine(cursor, file.end());
+        lineNumber++;
+        if(trim(line).empty() || line.front() == '#') continue;
+
+        std::string_view name = trim(nextField(line));
+        double latitude, longitude;
+        if(!parseNumber(nextField(line), latitude) || !parseNumber(nextField(line), longitude)){
+            error = lineError(path, lineNumber, "expected name,latitude,longitude[,population]");
+            return false;
+        }
+
+        bool rowHasPopulation = !line.empty();
+        if(data.names.empty()){
+            hasPopulations = rowHasPopulation;
+            if(hasPopulations) data.populations.reserve(lines);
+        }
+        if(rowHasPopulation != hasPopulations){
+            error = lineError(path, lineNumber, "population column must be present on every row or none");
+            return false;
+        }
+        if(hasPopulations){
+            int population;
+            if(!parseNumber(line, population)){
+                error = lineError(path, lineNumber, "expected an integer population");
+                return false;
+            }
+            data.populations.push_back(population);
+        }
+
+        data.names.emplace_back(name);
+        data.latitudes.push_back(latitude);
+        data.longitudes.push_back(longitude);
+    }
+    return true;
+}
+
+struct Route {
+    int to;
+    int distance;
+};
+
+// Contiguous run of routes leaving one island, either in a Graph or in a mapped snapshot.
+struct RouteSpan {
+    const Route* first;
+    const Route* last;
+
+    const Route* begin() const { return first; }
+    const Route* end() const { return last; }
+    size_t size() const { return last - first; }
+};
+
+const int unreachable = std::numeric_limits<int>::max();
+
+struct ShortestPaths {
+    int source;
+    std::vector<int> distance;  // unreachable when no route exists
+    std::vector<int> previous;  // -1 for the source and unreachable islands
+    std::vector<int> order;     // reachable islands in the order they were settled
+};
+
+struct MstEdge {
+    int from;
+    int to;
+    int distance;
+};
+
+struct SpanningTree {
+    int source;
+    std::vector<int> parent;    // -1 for the source and islands outside the tree
+    std::vector<MstEdge> edges; // in the order islands joined the tree
+};
+
+// Dijkstra over any graph exposing size() and routes(island).
+template <typename G>
+ShortestPaths shortestPaths(const G& graph, int source){
+    int n = graph.size();
+    ShortestPaths result;
+    result.source = source;
+    result.distance.assign(n, unreachable);
+    result.previous.assign(n, -1);
+    result.order.reserve(n);
+
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int,int>>> queue;
+    result.distance[source] = 0;
+    queue.push({0, source});
+    size_t pushes = 1;
+    size_t stalePops = 0;
+
+    while(!queue.empty()){
+        int distance = queue.top().first;
+        int island = queue.top().second;
+        queue.pop();
+
+        if(distance > result.distance[island]){
+            stalePops++;
+            continue;
+        }
+        result.order.push_back(island);
+
+        for(const Route& route : graph.routes(island)){
+            int adjacent = route.to;
+            // Widened so two long routes cannot overflow; such a sum is never below an int.
+            long long new_distance = static_cast<long long>(distance) + route.distance;
+
+            if(new_distance < result.distance[adjacent]){
+                result.distance[adjacent] = static_cast<int>(new_distance);
+                result.previous[adjacent] = island;
+                queue.push({static_cast<int>(new_distance), adjacent});
+                pushes++;
+            }
+        }
+    }
+    METRIC_COUNT("dijkstra_heap_pushes", pushes);
+    METRIC_COUNT("dijkstra_stale_pops", stalePops);
+    return result;
+}
+
+// Prim's algorithm grown from source; islands it cannot reach keep parent -1.
+template <typename G>
+SpanningTree spanningTree(const G& graph, int source){
+    int n = graph.size();
+    SpanningTree result;
+    result.source = source;
+    result.parent.assign(n, -1);
+
+    std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int>>, std::greater<std::pair<int,int>>> queue;
+    std::vector<int> key(n, unreachable);
+    std::vector<bool> visited(n, false);
+
+    queue.push({0, source});
+    key[source] = 0;
+
+    while(!queue.empty()){
+        int island = queue.top().second;
+        queue.pop();
+
+        if(visited[island] == true) continue;
+        visited[island] = true;
+        if(island != source){
+            result.edges.push_back({result.parent[island], island, key[island]});
+        }
+
+        for(const Route& route : graph.routes(island)){
+            int neighbor = route.to;
+            int distance = route.distance;
+
+            if(visited[neighbor] == false && key[neighbor] > distance){
+                key[neighbor] = distance;
+                queue.push({key[neighbor], neighbor});
+                result.parent[neighbor] = island;
+            }
+        }
+    }
+    return result;
+}
+
+// Islands from the query source to island, or empty when island is unreachable.
+std::vector<int> routeTo(const std::vector<int>& previous, int source, int island){
+    std::vector<int> route;
+    if(island != source && previous[island] == -1) return route;
+    for(int current = island; current != -1; current = previous[current]){
+        route.push_back(current);
+    }
+    std::reverse(route.begin(), route.end());
+    return route;
+}
+
+// Console reporters reproducing the original shareKnowledge / specialResource output.
+template <typename G>
+void reportKnowledge(std::ostream& out, const G& graph, const ShortestPaths& paths){
+    out << "Island\t\t\tPopulation\tTotal Distance\tRoute\n";
+    out << "-----------------------------------------------------------------\n";
+    for(int island : paths.order){
+        out << graph.name(island) << "\t\t\t" << graph.population(island) << "\t\t" << paths.distance[island] << "\t\t" << island << "\n";
+    }
+}
+
+template <typename G>
+void reportResource(std::ostream& out, const G& graph, const SpanningTree& tree){
+    out << "Paths from " << graph.name(tree.source) << "\n";
+    for(int i = 0; i < graph.size(); i++){
+        if(i != tree.source && tree.parent[i] != -1){
+            std::vector<int> route = routeTo(tree.parent, tree.source, i);
+            out << std::setw(3) << tree.source;
+            for(size_t step = 1; step < route.size(); step++){
+                out << std::setw(3) << "->" << std::setw(3) << route[step];
+            }
+            out << "\n";
+        }
+    }
+}
+
+// Multi-criteria routing: minimise distance and hop count while maximising coverage, the total
+// population of the distinct islands a route passes through (source included).
+struct ParetoLabel {
+    long long distance;
+    int hops;
+    long long coverage;
+    int island;
+    int previous;   // index of the predecessor label, -1 at the source
+};
+
+struct ParetoOptions {
+    int maxHops = std::numeric_limits<int>::max();
+    size_t maxLabelsPerIsland = std::numeric_limits<size_t>::max();
+};
+
+struct ParetoFront {
+    int source;
+    std::vector<ParetoLabel> labels;
+    std::vector<std::vector<int> > front;  // non-dominated label indices per island, by distance
+};
+
+bool dominates(const ParetoLabel& a, const ParetoLabel& b){
+    return a.distance <= b.distance && a.hops <= b.hops && a.coverage >= b.coverage;
+}
+
+// Islands along a Pareto label's route, source first.
+std::vector<int> routeOf(const ParetoFront& pareto, int label){
+    std::vector<int> route;
+    for(int current = label; current != -1; current = pareto.labels[current].previous){
+        route.push_back(pareto.labels[current].island);
+    }
+    std::reverse(route.begin(), route.end());
+    return route;
+}
+
+// Label-setting search over simple routes in (distance, hops, -coverage) order.
+//
+// Routes never revisit an island, so what a route can still reach depends on the islands it has
+// used. A label is therefore only discarded for a label at the same island that is at least as
+// good on all three criteria and whose route uses a subset of its islands: every extension of
+// the discarded route is then also open to the other one. Labels that survive this but lose on
+// the criteria alone are kept for extension and left out of the reported front. Without options
+// the front is exact (and exponential in the worst case); maxHops and maxLabelsPerIsland bound
+// the search for large graphs at the cost of possibly missing routes.
+template <typename G>
+ParetoFront paretoRoutes(const G& graph, int source, const ParetoOptions& options = ParetoOptions()){
+    ParetoFront result;
+    result.source = source;
+    result.front.resize(graph.size());
+    std::vector<std::vector<int> > settledAt(graph.size());
+
+    typedef std::tuple<long long, int, long long, int> Entry;  // distance, hops, -coverage, pending label
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    std::vector<ParetoLabel> pending;
+
+    // Islands of the route being tested are stamped so each subset check is one walk of the
+    // existing label's route.
+    std::vector<int> stamp(graph.size(), 0);
+    int currentStamp = 0;
+    std::vector<int> onRoute(graph.size(), 0);  // 1 + the label whose route was marked last
+    auto dominatedAt = [&](const ParetoLabel& label){
+        currentStamp++;
+        stamp[label.island] = currentStamp;
+        for(int current = label.previous; current != -1; current = result.labels[current].previous){
+            stamp[result.labels[current].island] = currentStamp;
+        }
+        for(int existing : settledAt[label.island]){
+            if(!dominates(result.labels[existing], label)) continue;
+            bool subset = true;
+            for(int current = existing; current != -1 && subset; current = result.labels[current].previous){
+                subset = stamp[result.labels[current].island] == currentStamp;
+            }
+            if(subset) return true;
+        }
+        return false;
+    };
+
+    pending.push_back({0, 0, graph.population(source), source, -1});
+    queue.push(Entry(0, 0, -pending.back().coverage, 0));
+
+    while(!queue.empty()){
+        ParetoLabel label = pending[std::get<3>(queue.top())];
+        queue.pop();
+
+        std::vector<int>& settled = settledAt[label.island];
+        if(settled.size() >= options.maxLabelsPerIsland || dominatedAt(label)) continue;
+
+        int index = result.labels.size();
+        result.labels.push_back(label);
+        settled.push_back(index);
+        if(label.hops >= options.maxHops) continue;
+
+        for(int current = index; current != -1; current = result.labels[current].previous){
+            onRoute[result.labels[current].island] = index + 1;
+        }
+        for(const Route& route : graph.routes(label.island)){
+            if(onRoute[route.to] == index + 1) continue;
+
+            ParetoLabel next = {label.distance + route.distance, label.hops + 1, label.coverage + graph.population(route.to), route.to, index};
+            if(dominatedAt(next)) continue;
+
+            queue.push(Entry(next.distance, next.hops, -next.coverage, pending.size()));
+            pending.push_back(next);
+        }
+    }
+
+    // Labels settle in (distance, hops, -coverage) order, so a label can only be beaten by an
+    // earlier one; of several with equal criteria the first stands for all.
+    for(int island = 0; island < graph.size(); island++){
+        for(int candidate : settledAt[island]){
+            bool beaten = false;
+            for(int kept : result.front[island]){
+                beaten = dominates(result.labels[kept], result.labels[candidate]);
+                if(beaten) break;
+            }
+            if(!beaten) result.front[island].push_back(candidate);
+        }
+    }
+    return result;
+}
+
+// Weighted-sum fast path. Coverage enters as a per-stop shortfall (largest population minus the
+// population of the island reached) so every route cost is non-negative and Dijkstra applies.
+// Weights must be non-negative.
+//
+// Because the shortfall is charged per stop, the population weight also adds population times
+// the ceiling to every hop. Raising it steers weightedRoutes toward fewer, more populous stops;
+// it never buys a longer route that reaches more people. To weigh total coverage against
+// distance, take paretoRoutes' front and pick from it with weightedChoice.
+struct CriteriaWeights {
+    double distance;
+    double hops;
+    double population;
+};
+
+struct WeightedPaths {
+    CriteriaWeights weights;
+    int source;
+    std::vector<double> cost;          // infinity when unreachable
+    std::vector<int> previous;
+    std::vector<long long> distance;
+    std::vector<int> hops;
+    std::vector<long long> coverage;
+};
+
+template <typename G>
+long long populationCeiling(const G& graph){
+    long long ceiling = 0;
+    for(int i = 0; i < graph.size(); i++){
+        ceiling = std::max<long long>(ceiling, graph.population(i));
+    }
+    return ceiling;
+}
+
+template <typename G>
+WeightedPaths weightedRoutes(const G& graph, int source, const CriteriaWeights& weights, long long ceiling){
+    int n = graph.size();
+    WeightedPaths result;
+    result.weights = weights;
+    result.source = source;
+    result.cost.assign(n, std::numeric_limits<double>::infinity());
+    result.previous.assign(n, -1);
+    result.distance.assign(n, 0);
+    result.hops.assign(n, 0);
+    result.coverage.assign(n, 0);
+
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int> >, std::greater<std::pair<double, int> > > queue;
+    result.cost[source] = 0;
+    result.coverage[source] = graph.population(source);
+    queue.push({0, source});
+
+    while(!queue.empty()){
+        double cost = queue.top().first;
+        int island = queue.top().second;
+        queue.pop();
+
+        if(cost > result.cost[island]) continue;
+
+        for(const Route& route : graph.routes(island)){
+            int adjacent = route.to;
+            double new_cost = cost + weights.distance * route.distance + weights.hops
+                + weights.population * (ceiling - graph.population(adjacent));
+
+            if(new_cost < result.cost[adjacent]){
+                result.cost[adjacent] = new_cost;
+                result.previous[adjacent] = island;
+                result.distance[adjacent] = result.distance[island] + route.distance;
+                result.hops[adjacent] = result.hops[island] + 1;
+                result.coverage[adjacent] = result.coverage[island] + graph.population(adjacent);
+                queue.push({new_cost, adjacent});
+            }
+        }
+    }
+    return result;
+}
+
+template <typename G>
+WeightedPaths weightedRoutes(const G& graph, int source, const CriteriaWeights& weights){
+    return weightedRoutes(graph, source, weights, populationCeiling(graph));
+}
+
+// The label on island's Pareto front with the lowest weights.distance * distance + weights.hops
+// * hops - weights.population * coverage. With the default ParetoOptions every simple route is
+// matched or beaten by a front label, so this is the best route overall. -1 when the island is
+// unreachable; ties go to the earlier label.
+int weightedChoice(const ParetoFront& pareto, int island, const CriteriaWeights& weights){
+    int best = -1;
+    double bestScore = 0;
+    for(int label : pareto.front[island]){
+        const ParetoLabel& l = pareto.labels[label];
+        double score = weights.distance * l.distance + weights.hops * l.hops - weights.population * l.coverage;
+        if(best == -1 || score < bestScore){
+            best = label;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// Runs one weighted search per weighting on up to threads workers (0 = one per core).
+template <typename G>
+std::vector<WeightedPaths> weightedRoutes(const G& graph, int source, const std::vector<CriteriaWeights>& weightings, unsigned threads = 0){
+    std::vector<WeightedPaths> results(weightings.size());
+    if(weightings.empty()) return results;
+
+    if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<size_t>(threads, weightings.size());
+
+    long long ceiling = populationCeiling(graph);
+    std::atomic<size_t> next(0);
+    auto worker = [&](){
+        for(size_t i = next++; i < weightings.size(); i = next++){
+            results[i] = weightedRoutes(graph, source, weightings[i], ceiling);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned t = 1; t < threads; t++){
+        pool.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& thread : pool){
+        thread.join();
+    }
+    return results;
+}
 
 class Graph {
 private:
-    std::vector<std::vector<int> > adjMatrix;
+    std::vector<std::vector<Route> > adjList;
     std::vector<std::string> islandName;
     std::vector<int> populations;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
     std::unordered_map<std::string, int> index;
     int islandCount;
 
 public:
     Graph(int n) : islandCount(n) {
-        adjMatrix.resize(n, std::vector<int>(n, std::numeric_limits<int>::max()));
+        adjList.resize(n);
         populations.resize(n, 0);
         islandName.resize(n);
-        for(int i = 0; i < n; i++){
-            adjMatrix[i][i] = 0;
+        latitudes.resize(n, 0.0);
+        longitudes.resize(n, 0.0);
+    }
+
+    // Sizes the graph from the loaded data; populations default to 0 when absent.
+    explicit Graph(const IslandData& data) : Graph(data.size()) {
+        index.reserve(data.size());
+        for(int i = 0; i < islandCount; i++){
+            int population = data.populations.empty() ? 0 : data.populations[i];
+            addIsland(i, data.names[i], population, data.latitudes[i], data.longitudes[i]);
         }
     }
 
@@ -33,139 +606,381 @@ public:
         populations[id] = population;
     }
 
+    void addIsland(int id, const std::string& name, int population, double latitude, double longitude) {
+        addIsland(id, name, population);
+        latitudes[id] = latitude;
+        longitudes[id] = longitude;
+    }
+
+    void addRoute(int u, int v, int distance) {
+        if(u == v) return;
+        for(Route& route : adjList[u]){
+            if(route.to == v){
+                route.distance = distance;
+                return;
+            }
+        }
+        adjList[u].push_back({v, distance});
+    }
+
+    // Bulk-load variant of addRoute: appends without looking for an existing route, so a
+    // repeated pair must be resolved by one dedupRoutes() call once loading is done.
+    void appendRoute(int u, int v, int distance) {
+        if(u != v) adjList[u].push_back({v, distance});
+    }
+
+    // Resolves repeats left by appendRoute as addRoute would have: each pair keeps the position
+    // of its first route and the distance of its last. O(islands + routes).
+    void dedupRoutes() {
+        std::vector<int> owner(islandCount, -1);
+        std::vector<size_t> position(islandCount);
+        for(int u = 0; u < islandCount; u++){
+            std::vector<Route>& list = adjList[u];
+            size_t kept = 0;
+            for(size_t i = 0; i < list.size(); i++){
+                Route route = list[i];
+                if(owner[route.to] == u){
+                    list[position[route.to]].distance = route.distance;
+                    continue;
+                }
+                owner[route.to] = u;
+                position[route.to] = kept;
+                list[kept++] = route;
+            }
+            list.resize(kept);
+        }
+    }
+
+    // Great-circle distance between two islands, rounded to whole kilometers.
+    int greatCircle(int u, int v) const {
+        return std::round(haversine(latitudes[u], longitudes[u], latitudes[v], longitudes[v]));
+    }
+
+    // Routes without an explicit distance use the great-circle distance between the islands.
+    void addRoute(int u, int v) {
+        addRoute(u, v, greatCircle(u, v));
+    }
+
     void addRoute(const std::string& from, const std::string& to, int distance) {
         int u = index[from];
         int v = index[to];
-        adjMatrix[u][v] = distance;
+        addRoute(u, v, distance);
     }
 
-    void specialResource(const std::string& source){
-        int sourceIdx = index[source];
-        std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int>>, std::greater<std::pair<int,int>>> queue;
-        std::vector<int> parent(islandCount, -1);
-        std::vector<int> key(islandCount, std::numeric_limits<int>::max());
-        std::vector<bool> visited(islandCount, false);
+    int size() const {
+        return islandCount;
+    }
 
-        queue.push({0, sourceIdx});
-        key[sourceIdx] = 0;
+    RouteSpan routes(int island) const {
+        const Route* first = adjList[island].data();
+        return {first, first + adjList[island].size()};
+    }
 
-        while(!queue.empty()){
-            int island = queue.top().second;
-            queue.pop();
+    bool writeSnapshot(const std::string& path, std::string& error) const;
 
-            if(visited[island] == true) continue;
-            visited[island] = true;
+    int find(const std::string& name) const {
+        auto found = index.find(name);
+        return found != index.end() ? found->second : -1;
+    }
 
-            for(int adjacent = 0; adjacent < islandCount; adjacent++){
-                if(adjMatrix[island][adjacent] != std::numeric_limits<int>::max()){
-                    int neighbor = adjacent;
-                    int distance = adjMatrix[island][adjacent];
+    std::string_view name(int island) const {
+        return islandName[island];
+    }
 
-                    if(visited[neighbor] == false && key[neighbor] > distance){
-                        key[neighbor] = distance;
-                        queue.push({key[neighbor], neighbor});
-                        parent[neighbor] = island;
-                    }
-                }
-            }
+    int population(int island) const {
+        return populations[island];
+    }
+
+    void specialResource(const std::string& source) const {
+        int sourceIdx = find(source);
+        if(sourceIdx < 0) return;
+        reportResource(std::cout, *this, spanningTree(*this, sourceIdx));
+    }
+
+    void shareKnowledge(const std::string& start) const {
+        int startIdx = find(start);
+        if(startIdx < 0) return;
+        reportKnowledge(std::cout, *this, shortestPaths(*this, startIdx));
+    }
+};
+
+// Loads "from,to[,distance]" lines of island indices; a missing distance is computed with haversine.
+bool loadRoutes(const std::string& path, Graph& graph, std::string& error){
+    MappedFile file(path);
+    if(!file.isOpen()){
+        error = "cannot open " + path;
+        return false;
+    }
+
+    const char* cursor = file.begin();
+    size_t lineNumber = 0;
+    while(cursor < file.end()){
+        std::string_view line = nextLine(cursor, file.end());
+        lineNumber++;
+        if(trim(line).empty() || line.front() == '#') continue;
+
+        int from, to;
+        if(!parseNumber(nextField(line), from) || !parseNumber(nextField(line), to)){
+            error = lineError(path, lineNumber, "expected from,to[,distance]");
+            return false;
+        }
+        if(from < 0 || from >= graph.size() || to < 0 || to >= graph.size()){
+            error = lineError(path, lineNumber, "island index out of range");
+            return false;
         }
 
-        std::cout << "Paths from " << source << std::endl;
-        for(int i = 0; i < islandCount; i++){
-            if(i != sourceIdx && parent[i] != -1){
-                std::stack<int> routeStack;
-                int current = i;
-                while(current != -1){
-                    routeStack.push(current);
-                    current = parent[current];
-                }
-                routeStack.pop();
-                std::cout << std::setw(3) << index[source];
-                while(!routeStack.empty()){
-                    std::cout << std::setw(3) << "->" << std::setw(3);
-                    std::cout << routeStack.top();
-                    routeStack.pop();
-                }
-            std::cout << std::endl;
-            }
+        if(line.empty()){
+            graph.appendRoute(from, to, graph.greatCircle(from, to));
+            continue;
+        }
+
+        double distance;
+        if(!parseNumber(line, distance)){
+            error = lineError(path, lineNumber, "expected a numeric distance");
+            return false;
+        }
+        // Rounded like greatCircle before the range check, so -0.4 still reads as 0.
+        distance = std::round(distance);
+        if(!std::isfinite(distance) || distance < 0 || distance > std::numeric_limits<int>::max()){
+            error = lineError(path, lineNumber, "distance must be between 0 and " + std::to_string(std::numeric_limits<int>::max()));
+            return false;
         }
+        graph.appendRoute(from, to, static_cast<int>(distance));
     }
+    graph.dedupRoutes();
+    return true;
+}
 
-    void shareKnowledge(const std::string& start){
-        int startIdx = index[start];
-        std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int,int>>> queue;
-        std::vector<int> shortest_distance(islandCount, std::numeric_limits<int>::max());
-        std::vector<int> previous(islandCount, -1);
 
-        shortest_distance[startIdx] = 0;
-        queue.push({0, startIdx});
-        
-        std::cout << "Island\t\t\tPopulation\tTotal Distance\tRoute\n";
-        std::cout << "-----------------------------------------------------------------\n";
+// Snapshot layout: a SnapshotHeader followed by 8-byte aligned sections at the recorded offsets.
+// Values are stored in host byte order; byteOrder lets a reader reject a foreign-endian file.
+const char snapshotMagic[8] = {'I', 'S', 'L', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t snapshotVersion = 1;
+const uint32_t snapshotByteOrder = 0x01020304;
 
-        while(!queue.empty()){
-            int distance = queue.top().first;
-            int island = queue.top().second;
-            queue.pop();
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t islandCount;
+    uint64_t routeCount;
+    uint64_t nameBytes;
+    uint64_t fileSize;
+    uint64_t populationsOffset;     // int32_t[islandCount]
+    uint64_t latitudesOffset;       // double[islandCount]
+    uint64_t longitudesOffset;      // double[islandCount]
+    uint64_t nameOffsetsOffset;     // uint32_t[islandCount + 1] into the name bytes
+    uint64_t nameOrderOffset;       // uint32_t[islandCount], island ids sorted by name
+    uint64_t routeOffsetsOffset;    // uint64_t[islandCount + 1] into the routes (CSR)
+    uint64_t routesOffset;          // Route[routeCount]
+    uint64_t namesOffset;           // char[nameBytes], names concatenated without separators
+};
 
-            if(distance > shortest_distance[island]) continue;
+static_assert(sizeof(Route) == 8 && sizeof(int) == 4, "snapshot routes are stored as two int32 values");
 
-            std::cout << islandName[island] << "\t\t\t" << populations[island] << "\t\t" << distance << "\t\t" << island;
-            std::cout << std::endl;
+uint64_t alignSection(uint64_t offset){
+    return (offset + 7) & ~uint64_t(7);
+}
 
-            for(int adjacent = 0; adjacent < islandCount; adjacent++){
-                if(adjMatrix[island][adjacent] != std::numeric_limits<int>::max()){
-                    int new_distance = distance + adjMatrix[island][adjacent];
+bool Graph::writeSnapshot(const std::string& path, std::string& error) const {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = snapshotVersion;
+    header.byteOrder = snapshotByteOrder;
+    header.islandCount = islandCount;
 
-                    if(new_distance < shortest_distance[adjacent]){
-                        shortest_distance[adjacent] = new_distance;
-                        previous[adjacent] = island;
-                        queue.push({new_distance,adjacent});
-                    }
-                }
-            }
+    std::vector<uint32_t> nameOffsets(islandCount + 1, 0);
+    std::vector<uint64_t> routeOffsets(islandCount + 1, 0);
+    for(int i = 0; i < islandCount; i++){
+        header.nameBytes += islandName[i].size();
+        if(header.nameBytes > std::numeric_limits<uint32_t>::max()){
+            error = "island names exceed the 4 GiB snapshot limit";
+            return false;
         }
+        nameOffsets[i + 1] = header.nameBytes;
+        routeOffsets[i + 1] = routeOffsets[i] + adjList[i].size();
     }
-};
+    header.routeCount = routeOffsets[islandCount];
 
-double dtor(double deg){
-    return ((deg*M_PI)/180.0);
-}
+    std::vector<uint32_t> nameOrder(islandCount);
+    for(int i = 0; i < islandCount; i++) nameOrder[i] = i;
+    std::sort(nameOrder.begin(), nameOrder.end(), [this](uint32_t a, uint32_t b){
+        return islandName[a] < islandName[b];
+    });
 
-double haversine(double lat1, double lon1, double lat2, double lon2){
-    return (2*6371*asin(sqrt((pow((sin(dtor(lon1-lon2))/2), 2.0))+(pow((sin(dtor(lat1-lat2))/2), 2.0))*cos(dtor(lon1))*cos(dtor(lon2)))));
+    uint64_t n = islandCount;
+    header.populationsOffset = alignSection(sizeof(SnapshotHeader));
+    header.latitudesOffset = alignSection(header.populationsOffset + n * sizeof(int32_t));
+    header.longitudesOffset = alignSection(header.latitudesOffset + n * sizeof(double));
+    header.nameOffsetsOffset = alignSection(header.longitudesOffset + n * sizeof(double));
+    header.nameOrderOffset = alignSection(header.nameOffsetsOffset + (n + 1) * sizeof(uint32_t));
+    header.routeOffsetsOffset = alignSection(header.nameOrderOffset + n * sizeof(uint32_t));
+    header.routesOffset = alignSection(header.routeOffsetsOffset + (n + 1) * sizeof(uint64_t));
+    header.namesOffset = alignSection(header.routesOffset + header.routeCount * sizeof(Route));
+    header.fileSize = header.namesOffset + header.nameBytes;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if(!out){
+        error = "cannot create " + path;
+        return false;
+    }
+
+    uint64_t written = 0;
+    auto section = [&](uint64_t offset, const void* bytes, uint64_t length){
+        static const char padding[8] = {0};
+        out.write(padding, offset - written);
+        out.write(static_cast<const char*>(bytes), length);
+        written = offset + length;
+    };
+
+    section(0, &header, sizeof(header));
+    section(header.populationsOffset, populations.data(), n * sizeof(int32_t));
+    section(header.latitudesOffset, latitudes.data(), n * sizeof(double));
+    section(header.longitudesOffset, longitudes.data(), n * sizeof(double));
+    section(header.nameOffsetsOffset, nameOffsets.data(), (n + 1) * sizeof(uint32_t));
+    section(header.nameOrderOffset, nameOrder.data(), n * sizeof(uint32_t));
+    section(header.routeOffsetsOffset, routeOffsets.data(), (n + 1) * sizeof(uint64_t));
+    section(header.routesOffset, nullptr, 0);
+    for(int i = 0; i < islandCount; i++){
+        out.write(reinterpret_cast<const char*>(adjList[i].data()), adjList[i].size() * sizeof(Route));
+    }
+    written += header.routeCount * sizeof(Route);
+    section(header.namesOffset, nullptr, 0);
+    for(int i = 0; i < islandCount; i++){
+        out.write(islandName[i].data(), islandName[i].size());
+    }
+
+    if(!out.flush()){
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
 }
 
-int main(){
-    int n = 44;
-    std::ifstream islandsfile("islands.txt");
-    std::ifstream latsfile("lats.txt");
-    std::ifstream longsfile("longs.txt");
-    std::string island;
-    std::string lats;
-    std::string longs;
-    std::vector<std::string> islands;
-    std::vector<double> latitudes;
-    std::vector<double> longitudes;
-    srand(time(0));
-    Graph graph(n);
+// Read-only graph served straight from a mapped snapshot file. Opening only checks the header
+// and section bounds; every accessor reads the mapping in place.
+class GraphSnapshot {
+private:
+    MappedFile file;
+    const SnapshotHeader* header;
+    const int32_t* populations;
+    const double* latitudes;
+    const double* longitudes;
+    const uint32_t* nameOffsets;
+    const uint32_t* nameOrder;
+    const uint64_t* routeOffsets;
+    const Route* routeData;
+    const char* names;
 
-    while(getline(islandsfile, island)){
-        islands.push_back(island);
+    template <typename T>
+    const T* sectionAt(uint64_t offset) const {
+        return reinterpret_cast<const T*>(file.begin() + offset);
     }
 
-    while(getline(latsfile, lats)){
-        latitudes.push_back((std::stod(lats)));
+    bool sectionFits(uint64_t offset, uint64_t count, uint64_t width) const {
+        return offset % 8 == 0 && offset <= file.size() && count <= (file.size() - offset) / width;
     }
 
-    while(getline(longsfile, longs)){
-        longitudes.push_back((std::stod(longs)));
+    // One O(islands + routes) pass over everything the accessors index with: offsets start at 0
+    // and never decrease, every route target and name-order entry is an island id, and no route
+    // distance is negative.
+    bool indexesValid(uint64_t n) const {
+        if(nameOffsets[0] != 0 || routeOffsets[0] != 0) return false;
+        for(uint64_t i = 0; i < n; i++){
+            if(nameOffsets[i] > nameOffsets[i + 1] || routeOffsets[i] > routeOffsets[i + 1] || nameOrder[i] >= n) return false;
+        }
+        for(uint64_t r = 0; r < routeOffsets[n]; r++){
+            if(routeData[r].to < 0 || static_cast<uint64_t>(routeData[r].to) >= n || routeData[r].distance < 0) return false;
+        }
+        return true;
     }
 
-    for(int i = 0; i < n; i++){
-        graph.addIsland(i, islands[i], ((std::rand()%451) + 50));
+public:
+    GraphSnapshot() : header(nullptr) {
+    }
+
+    bool open(const std::string& path, std::string& error){
+        file = MappedFile(path, MADV_WILLNEED);
+        header = nullptr;
+        if(!file.isOpen()){
+            error = "cannot open " + path;
+            return false;
+        }
+
+        const SnapshotHeader* candidate = sectionAt<SnapshotHeader>(0);
+        if(file.size() < sizeof(SnapshotHeader) || memcmp(candidate->magic, snapshotMagic, sizeof(snapshotMagic)) != 0){
+            error = path + " is not an island graph snapshot";
+            return false;
+        }
+        if(candidate->version != snapshotVersion || candidate->byteOrder != snapshotByteOrder){
+            error = path + " has an unsupported snapshot version or byte order";
+            return false;
+        }
+
+        uint64_t n = candidate->islandCount;
+        if(candidate->fileSize != file.size() || n >= std::numeric_limits<int>::max()
+            || !sectionFits(candidate->populationsOffset, n, sizeof(int32_t))
+            || !sectionFits(candidate->latitudesOffset, n, sizeof(double))
+            || !sectionFits(candidate->longitudesOffset, n, sizeof(double))
+            || !sectionFits(candidate->nameOffsetsOffset, n + 1, sizeof(uint32_t))
+            || !sectionFits(candidate->nameOrderOffset, n, sizeof(uint32_t))
+            || !sectionFits(candidate->routeOffsetsOffset, n + 1, sizeof(uint64_t))
+            || !sectionFits(candidate->routesOffset, candidate->routeCount, sizeof(Route))
+            || !sectionFits(candidate->namesOffset, candidate->nameBytes, 1)){
+            error = path + " is truncated or corrupt";
+            return false;
+        }
+
+        nameOffsets = sectionAt<uint32_t>(candidate->nameOffsetsOffset);
+        routeOffsets = sectionAt<uint64_t>(candidate->routeOffsetsOffset);
+        nameOrder = sectionAt<uint32_t>(candidate->nameOrderOffset);
+        routeData = sectionAt<Route>(candidate->routesOffset);
+        if(nameOffsets[n] != candidate->nameBytes || routeOffsets[n] != candidate->routeCount || !indexesValid(n)){
+            error = path + " is truncated or corrupt";
+            return false;
+        }
+
+        header = candidate;
+        populations = sectionAt<int32_t>(header->populationsOffset);
+        latitudes = sectionAt<double>(header->latitudesOffset);
+        longitudes = sectionAt<double>(header->longitudesOffset);
+        names = sectionAt<char>(header->namesOffset);
+        return true;
     }
 
+    int size() const { return header != nullptr ? header->islandCount : 0; }
+    uint64_t routeCount() const { return header != nullptr ? header->routeCount : 0; }
+
+    std::string_view name(int island) const {
+        return std::string_view(names + nameOffsets[island], nameOffsets[island + 1] - nameOffsets[island]);
+    }
+
+    int population(int island) const { return populations[island]; }
+    double latitude(int island) const { return latitudes[island]; }
+    double longitude(int island) const { return longitudes[island]; }
+
+    RouteSpan routes(int island) const {
+        return {routeData + routeOffsets[island], routeData + routeOffsets[island + 1]};
+    }
+
+    // Binary search over the name-sorted id table; returns -1 for unknown islands.
+    int find(std::string_view islandName) const {
+        const uint32_t* first = nameOrder;
+        const uint32_t* last = nameOrder + size();
+        const uint32_t* found = std::lower_bound(first, last, islandName, [this](uint32_t id, std::string_view key){
+            return name(id) < key;
+        });
+        return found != last && name(*found) == islandName ? static_cast<int>(*found) : -1;
+    }
+};
+
+// Hard-coded route network for the bundled islands.txt / lats.txt / longs.txt data set.
+void addPacificRoutes(Graph& graph, const IslandData& data){
+    const std::vector<std::string>& islands = data.names;
+    const std::vector<double>& latitudes = data.latitudes;
+    const std::vector<double>& longitudes = data.longitudes;
+
     // Connected graph for region of Hawai'i
     for(int x = 0; x < 8; x++){
         for(int y = 0; y < 8; y++){
@@ -302,10 +1117,84 @@ int main(){
     graph.addRoute(islands[41], islands[30], 2071.56);
 
     graph.addRoute(islands[42], islands[6], 3998.79);
+}
+
+#ifndef NO_MAIN
+int main(int argc, char* argv[]){
+    METRICS_DUMP_AT_EXIT();
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string error;
+
+    if((args.size() == 2 || args.size() == 3) && args[0] == "--snapshot"){
+        GraphSnapshot snapshot;
+        if(!snapshot.open(args[1], error)){
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        int source = args.size() > 2 ? snapshot.find(args[2]) : 0;
+        if(source < 0 || snapshot.size() == 0){
+            std::cerr << "unknown island" << std::endl;
+            return 1;
+        }
+        reportKnowledge(std::cout, snapshot, shortestPaths(snapshot, source));
+        reportResource(std::cout, snapshot, spanningTree(snapshot, source));
+        return 0;
+    }
+
+    std::string snapshotPath;
+    if(args.size() >= 2 && args[args.size() - 2] == "--write-snapshot"){
+        snapshotPath = args.back();
+        args.resize(args.size() - 2);
+    }
+
+    IslandData data;
+    bool loaded = !args.empty() ? loadIslandCsv(args[0], data, error) : loadIslandFiles("islands.txt", "lats.txt", "longs.txt", data, error);
+    if(!loaded){
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if(data.names.empty()){
+        std::cerr << (!args.empty() ? args[0] : std::string("islands.txt")) << ": no islands" << std::endl;
+        return 1;
+    }
+
+    srand(time(0));
+    if(data.populations.empty()){
+        data.populations.reserve(data.size());
+        for(int i = 0; i < data.size(); i++){
+            data.populations.push_back((std::rand()%451) + 50);
+        }
+    }
+    Graph graph(data);
+
+    // Custom data sets bring their own routes: island.csv routes.csv
+    if(!args.empty()){
+        if(args.size() < 2 || !loadRoutes(args[1], graph, error)){
+            std::cerr << (args.size() < 2 ? "usage: island [islands.csv routes.csv] [--write-snapshot graph.bin] | --snapshot graph.bin [island]" : error) << std::endl;
+            return 1;
+        }
+    }
+    else{
+        addPacificRoutes(graph, data);
+    }
+
+    if(!snapshotPath.empty()){
+        if(!graph.writeSnapshot(snapshotPath, error)){
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        return 0;
+    }
 
     // Algorithms
-    graph.shareKnowledge(islands[0]);
-    graph.specialResource(islands[6]);
-    graph.specialResource(islands[1]);
+    if(!args.empty()){
+        graph.shareKnowledge(data.names[0]);
+        graph.specialResource(data.names[0]);
+        return 0;
+    }
+    graph.shareKnowledge(data.names[0]);
+    graph.specialResource(data.names[6]);
+    graph.specialResource(data.names[1]);
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -5,6 +5,8 @@
 #include <string>
 #include <sstream>
 
+#include "../common/metrics.h"
+
 class Graph {
 private:
     std::unordered_map<std::string, std::vector<std::string>> adjList;
@@ -57,6 +59,7 @@ int gcd(int a, int b){
 }
 
 int modulusExp(int base, int pow, int mod){
+    METRIC_TIME("modulus_exp_ns");
     int temp = 1;
 
     base = base % mod;
@@ -143,6 +146,7 @@ std::vector<std::string> breadthFirstSearch(const Graph& graph, const std::strin
     std::queue<std::string> queue;
     std::unordered_map<std::string, bool> visited;
     std::vector<std::string> path;
+    size_t explored = 0;
 
     queue.push(sender);
     visited[sender] = true;
@@ -150,6 +154,7 @@ std::vector<std::string> breadthFirstSearch(const Graph& graph, const std::strin
     while (!queue.empty()){
         std::string current = queue.front();
         queue.pop();
+        explored++;
 
         if (current == receiver){
             while (current != sender){
@@ -157,6 +162,7 @@ std::vector<std::string> breadthFirstSearch(const Graph& graph, const std::strin
                 current = parent[current];
             }
             path.insert(path.begin(), sender);
+            METRIC_RECORD("bfs_nodes_visited", explored);
             return path;
         }
 
@@ -168,6 +174,7 @@ std::vector<std::string> breadthFirstSearch(const Graph& graph, const std::strin
             }
         }
     }
+    METRIC_RECORD("bfs_nodes_visited", explored);
     return {};
 }
 
@@ -227,7 +234,9 @@ Message verifyRSAMessage(const Graph& graph, const std::string& sender, const st
     return { sender, receiver, "RSA Verification", boolToString(verifiedMessage), path };
 }
 
+#ifndef NO_MAIN
 int main(){
+    METRICS_DUMP_AT_EXIT();
     Graph network;
 
     network.addUser("Vic");
@@ -328,3 +337,4 @@ int main(){
 
     return 0;
 }
+#endif